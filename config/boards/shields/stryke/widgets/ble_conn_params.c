@@ -0,0 +1,109 @@
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/logging/log.h>
+#include <zmk/activity.h>
+#include <zmk/ble.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/ble_active_profile_changed.h>
+#include "ble_conn_params.h"
+
+LOG_MODULE_REGISTER(stryke_ble_conn, CONFIG_ZMK_LOG_LEVEL);
+
+#define CONN_PARAM_SETTLE_DELAY_MS 1000
+
+static struct k_spinlock params_lock;
+static struct stryke_ble_conn_params current_params;
+
+static void conn_params_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(conn_params_work, conn_params_work_cb);
+
+static void set_current_params(bool connected, uint16_t interval, uint16_t latency, uint16_t timeout) {
+    k_spinlock_key_t key = k_spin_lock(&params_lock);
+    current_params.connected = connected;
+    current_params.interval = interval;
+    current_params.latency = latency;
+    current_params.timeout = timeout;
+    k_spin_unlock(&params_lock, key);
+}
+
+void stryke_ble_conn_get_params(struct stryke_ble_conn_params *params) {
+    k_spinlock_key_t key = k_spin_lock(&params_lock);
+    *params = current_params;
+    k_spin_unlock(&params_lock, key);
+}
+
+static struct bt_conn* get_active_conn(void) {
+    if (!zmk_ble_active_profile_is_connected()) {
+        return NULL;
+    }
+    return bt_conn_lookup_addr_le(BT_ID_DEFAULT, zmk_ble_active_profile_addr());
+}
+
+static void conn_params_work_cb(struct k_work *work) {
+    struct bt_conn *conn = get_active_conn();
+    if (conn == NULL) {
+        set_current_params(false, 0, 0, 0);
+        return;
+    }
+
+    struct bt_conn_info info;
+    if (bt_conn_get_info(conn, &info) == 0) {
+        set_current_params(true, info.le.interval, info.le.latency, info.le.timeout);
+    }
+
+    struct bt_le_conn_param param;
+    if (zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE) {
+        param = (struct bt_le_conn_param)BT_LE_CONN_PARAM_INIT(
+            CONFIG_STRYKE_BLE_ACTIVE_MIN_INT, CONFIG_STRYKE_BLE_ACTIVE_MAX_INT,
+            0, CONFIG_STRYKE_BLE_SUPERVISION_TIMEOUT);
+    } else {
+        param = (struct bt_le_conn_param)BT_LE_CONN_PARAM_INIT(
+            CONFIG_STRYKE_BLE_IDLE_MIN_INT, CONFIG_STRYKE_BLE_IDLE_MAX_INT,
+            CONFIG_STRYKE_BLE_IDLE_LATENCY, CONFIG_STRYKE_BLE_SUPERVISION_TIMEOUT);
+    }
+
+    int err = bt_conn_le_param_update(conn, &param);
+    if (err < 0 && err != -EALREADY) {
+        LOG_WRN("Connection parameter update failed (err %d)", err);
+    }
+
+    bt_conn_unref(conn);
+}
+
+static void conn_connected(struct bt_conn *conn, uint8_t err) {
+    if (err) return;
+    k_work_reschedule(&conn_params_work, K_MSEC(CONN_PARAM_SETTLE_DELAY_MS));
+}
+
+static void conn_disconnected(struct bt_conn *conn, uint8_t reason) {
+    k_work_reschedule(&conn_params_work, K_NO_WAIT);
+}
+
+static void conn_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency, uint16_t timeout) {
+    struct bt_conn *active = get_active_conn();
+    if (active == NULL) return;
+
+    if (active == conn) {
+        LOG_DBG("Connection parameters: interval %d latency %d timeout %d", interval, latency, timeout);
+        set_current_params(true, interval, latency, timeout);
+    }
+
+    bt_conn_unref(active);
+}
+
+BT_CONN_CB_DEFINE(stryke_conn_callbacks) = {
+    .connected = conn_connected,
+    .disconnected = conn_disconnected,
+    .le_param_updated = conn_param_updated,
+};
+
+static int conn_params_event_cb(const zmk_event_t *eh) {
+    k_work_reschedule(&conn_params_work, K_NO_WAIT);
+    return 0;
+}
+
+ZMK_LISTENER(stryke_ble_conn, conn_params_event_cb);
+ZMK_SUBSCRIPTION(stryke_ble_conn, zmk_activity_state_changed);
+ZMK_SUBSCRIPTION(stryke_ble_conn, zmk_ble_active_profile_changed);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct stryke_ble_conn_params {
+    bool connected;
+    uint16_t interval;
+    uint16_t latency;
+    uint16_t timeout;
+};
+
+void stryke_ble_conn_get_params(struct stryke_ble_conn_params *params);
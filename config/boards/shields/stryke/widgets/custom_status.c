@@ -1,4 +1,5 @@
 #include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
 #include <zmk/display/status_screen.h>
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/events/position_state_changed.h>
@@ -6,11 +7,22 @@
 #include <zmk/keymap.h>
 #include <lvgl.h>
 #include "custom_bitmap.h"
+#include "custom_status.h"
+
+#if IS_ENABLED(CONFIG_STRYKE_BLE_LOW_LATENCY)
+#include "ble_conn_params.h"
+#endif
+
+#if IS_ENABLED(CONFIG_STRYKE_KEY_LABELS)
+#include "key_labels.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+LOG_MODULE_REGISTER(custom_status, CONFIG_ZMK_LOG_LEVEL);
+
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define MAX_TEXT_HEIGHT 16
@@ -19,6 +31,15 @@ extern "C" {
 
 #define BOOT_SCREEN_DURATION_MS 10000
 
+#define PENDING_LAYER BIT(0)
+#define PENDING_KEY BIT(1)
+
+#define STATS_LOG_INTERVAL_MS 5000
+
+/* Widest readout is "4000MSL499": 10 glyphs of 5 px plus 1 px spacing. */
+#define CONN_IMG_WIDTH 60
+#define CONN_IMG_HEIGHT 5
+
 typedef enum {
     DISPLAY_STATE_BOOT_SCREEN,
     DISPLAY_STATE_MAIN_UI
@@ -45,6 +66,7 @@ static lv_obj_t *main_container = NULL;
 static lv_obj_t *key_label = NULL;
 static lv_obj_t *time_img = NULL;
 static lv_obj_t *layer_img = NULL;
+static lv_obj_t *conn_img = NULL;
 static lv_obj_t *bg_canvas = NULL;
 static lv_obj_t *booting_label = NULL;
 
@@ -53,8 +75,29 @@ static char last_key_text[32] = " ";
 static int64_t last_key_time = 0;
 static bool force_layer_update = false;
 
+/*
+ * The listeners run on the system work queue, between the kscan and the HID
+ * report, while LVGL runs on the display work queue. They only record what
+ * changed here; the display timer applies it, so LVGL stays on one thread
+ * and a burst of events between two frames costs a single redraw.
+ */
+static struct k_spinlock pending_lock;
+static uint8_t pending_flags = 0;
+static uint8_t listener_layer = 0;
+static char pending_key_text[32] = "";
+static int64_t pending_key_time = 0;
+
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+static struct k_spinlock stats_lock;
+static struct stryke_display_stats stats;
+static uint32_t events_at_last_redraw = 0;
+static int64_t last_frame_time = 0;
+static int64_t stats_last_log = 0;
+#endif
+
 static uint8_t cached_layer = 255;
 static char cached_time_str[6] = "";
+static char cached_conn_str[12] = "";
 
 static const uint8_t org_01_bitmaps[] = {
     0xFC, 0x63, 0x1F, 0x80,
@@ -148,6 +191,13 @@ static const char* key_names[MAX_LAYERS][MAX_POSITIONS] = {
 };
 
 static const char* get_key_name_by_position(uint8_t layer, uint8_t position) {
+#if IS_ENABLED(CONFIG_STRYKE_KEY_LABELS)
+    static char binding_label[32];
+    if (stryke_key_label_from_binding(layer, position, binding_label, sizeof(binding_label)) == 0) {
+        return binding_label;
+    }
+#endif
+    
     if (layer >= MAX_LAYERS || position >= MAX_POSITIONS) {
         return NULL;
     }
@@ -331,6 +381,11 @@ static void update_boot_screen(void) {
     update_boot_message();
     
     if (elapsed >= BOOT_SCREEN_DURATION_MS) {
+        /* Keys pressed behind the boot screen are stale by now. */
+        k_spinlock_key_t key = k_spin_lock(&pending_lock);
+        pending_flags &= ~PENDING_KEY;
+        k_spin_unlock(&pending_lock, key);
+        
         current_display_state = DISPLAY_STATE_MAIN_UI;
         lv_obj_add_flag(boot_container, LV_OBJ_FLAG_HIDDEN);
         lv_obj_clear_flag(main_container, LV_OBJ_FLAG_HIDDEN);
@@ -407,6 +462,35 @@ static void update_layer_display(void) {
     }
 }
 
+#if IS_ENABLED(CONFIG_STRYKE_BLE_LOW_LATENCY)
+static void update_conn_display(void) {
+    if (conn_img == NULL) return;
+    
+    struct stryke_ble_conn_params params;
+    stryke_ble_conn_get_params(&params);
+    
+    char conn_str[12] = "";
+    if (params.connected) {
+        /* Interval is in 1.25 ms units; round to the nearest millisecond. */
+        snprintf(conn_str, sizeof(conn_str), "%dMSL%d", (params.interval * 5 + 2) / 4, params.latency);
+    }
+    
+    if (strcmp(conn_str, cached_conn_str) == 0) {
+        return;
+    }
+    
+    strcpy(cached_conn_str, conn_str);
+    
+    lv_img_dsc_t* img_dsc = (lv_img_dsc_t*)lv_obj_get_user_data(conn_img);
+    if (img_dsc && img_dsc->data) {
+        lv_color_t* buf = (lv_color_t*)img_dsc->data;
+        memset(buf, 0, CONN_IMG_WIDTH * CONN_IMG_HEIGHT * sizeof(lv_color_t));
+        draw_org_string(buf, CONN_IMG_WIDTH, CONN_IMG_HEIGHT, conn_str, 0, 0);
+        lv_obj_invalidate(conn_img);
+    }
+}
+#endif
+
 static void update_key_display(void) {
     if (key_label == NULL) return;
     
@@ -479,6 +563,25 @@ static void create_main_ui(void) {
     lv_obj_set_pos(layer_img, 76, 2);
     lv_obj_set_user_data(layer_img, &layer_img_dsc);
     
+#if IS_ENABLED(CONFIG_STRYKE_BLE_LOW_LATENCY)
+    static lv_color_t conn_buf[CONN_IMG_WIDTH * CONN_IMG_HEIGHT];
+    static lv_img_dsc_t conn_img_dsc = {
+        .header.cf = LV_IMG_CF_TRUE_COLOR,
+        .header.always_zero = 0,
+        .header.reserved = 0,
+        .header.w = CONN_IMG_WIDTH,
+        .header.h = CONN_IMG_HEIGHT,
+        .data_size = CONN_IMG_WIDTH * CONN_IMG_HEIGHT * sizeof(lv_color_t),
+        .data = (uint8_t*)conn_buf,
+    };
+    memset(conn_buf, 0, sizeof(conn_buf));
+    
+    conn_img = lv_img_create(main_container);
+    lv_img_set_src(conn_img, &conn_img_dsc);
+    lv_obj_set_pos(conn_img, (SCREEN_WIDTH - CONN_IMG_WIDTH) / 2, 49);
+    lv_obj_set_user_data(conn_img, &conn_img_dsc);
+#endif
+    
     key_label = lv_label_create(main_container);
     lv_label_set_text(key_label, last_key_text);
     lv_obj_set_style_text_color(key_label, lv_color_make(100, 100, 100), LV_PART_MAIN);
@@ -489,19 +592,113 @@ static void create_main_ui(void) {
     
     cached_layer = 255;
     memset(cached_time_str, 0, sizeof(cached_time_str));
+    memset(cached_conn_str, 0, sizeof(cached_conn_str));
     
     update_time_display();
     update_layer_display();
     update_key_display();
 }
 
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+static void count_event(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    stats.events++;
+    k_spin_unlock(&stats_lock, key);
+}
+
+static void count_redraw(void) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    uint32_t folded = stats.events - events_at_last_redraw;
+    events_at_last_redraw = stats.events;
+    stats.redraws++;
+    if (folded > stats.max_events_per_redraw) {
+        stats.max_events_per_redraw = folded;
+    }
+    k_spin_unlock(&stats_lock, key);
+}
+
+/* How far past its period the display timer ran tells whether the display is keeping up. */
+static void count_frame(lv_timer_t* timer) {
+    int64_t now = k_uptime_get();
+    
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    if (last_frame_time != 0) {
+        int64_t late = now - last_frame_time - timer->period;
+        if (late > (int64_t)stats.max_frame_late_ms) {
+            stats.max_frame_late_ms = late;
+        }
+    }
+    last_frame_time = now;
+    stats.frames++;
+    k_spin_unlock(&stats_lock, key);
+}
+
+void stryke_display_get_stats(struct stryke_display_stats *out) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    *out = stats;
+    k_spin_unlock(&stats_lock, key);
+}
+
+static void log_display_stats(void) {
+    int64_t now = k_uptime_get();
+    if (now - stats_last_log < STATS_LOG_INTERVAL_MS) {
+        return;
+    }
+    stats_last_log = now;
+    
+    struct stryke_display_stats snapshot;
+    stryke_display_get_stats(&snapshot);
+    
+    LOG_INF("Display: %u events, %u redraws (max %u events each), %u frames (max %u ms late)",
+            snapshot.events, snapshot.redraws, snapshot.max_events_per_redraw,
+            snapshot.frames, snapshot.max_frame_late_ms);
+}
+#endif
+
+static void apply_pending_updates(void) {
+    k_spinlock_key_t key = k_spin_lock(&pending_lock);
+    uint8_t flags = pending_flags;
+    uint8_t layer = listener_layer;
+    if (flags & PENDING_KEY) {
+        memcpy(last_key_text, pending_key_text, sizeof(last_key_text));
+        last_key_time = pending_key_time;
+    }
+    pending_flags = 0;
+    k_spin_unlock(&pending_lock, key);
+    
+    if (flags & PENDING_LAYER) {
+        current_layer = layer;
+        force_layer_update = true;
+        update_layer_display();
+        
+        if (!(flags & PENDING_KEY)) {
+            strcpy(last_key_text, " ");
+        }
+    }
+    
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+    if (flags) {
+        count_redraw();
+    }
+#endif
+}
+
 static void animation_timer_cb(lv_timer_t* timer) {
     if (current_display_state == DISPLAY_STATE_BOOT_SCREEN) {
         update_boot_screen();
     } else {
+        apply_pending_updates();
         update_key_display();
         update_time_display();
+#if IS_ENABLED(CONFIG_STRYKE_BLE_LOW_LATENCY)
+        update_conn_display();
+#endif
     }
+    
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+    count_frame(timer);
+    log_display_stats();
+#endif
 }
 
 static int layer_state_changed_cb(const zmk_event_t *eh) {
@@ -509,25 +706,21 @@ static int layer_state_changed_cb(const zmk_event_t *eh) {
     if (ev == NULL) return 0;
     
     uint8_t new_layer = zmk_keymap_highest_layer_active();
+    if (new_layer >= MAX_LAYERS) {
+        new_layer = 0;
+    }
     
-    if (new_layer != current_layer) {
-        current_layer = new_layer;
-        
-        if (current_layer >= MAX_LAYERS) {
-            current_layer = 0;
-        }
-        
-        force_layer_update = true;
-        if (current_display_state == DISPLAY_STATE_MAIN_UI) {
-            update_layer_display();
-        }
-        
-        strcpy(last_key_text, " ");
-        if (current_display_state == DISPLAY_STATE_MAIN_UI) {
-            update_key_display();
-        }
+    k_spinlock_key_t key = k_spin_lock(&pending_lock);
+    if (new_layer != listener_layer) {
+        listener_layer = new_layer;
+        pending_flags |= PENDING_LAYER;
+        pending_flags &= ~PENDING_KEY;
     }
+    k_spin_unlock(&pending_lock, key);
     
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+    count_event();
+#endif
     return 0;
 }
 
@@ -538,17 +731,21 @@ static int position_state_changed_cb(const zmk_event_t *eh) {
     uint8_t position = ev->position;
     bool pressed = ev->state;
     
-    if (pressed && current_display_state == DISPLAY_STATE_MAIN_UI) {
-        const char* key_name = get_key_name_by_position(current_layer, position);
+    if (pressed) {
+        const char* key_name = get_key_name_by_position(listener_layer, position);
         
         if (key_name != NULL) {
-            strncpy(last_key_text, key_name, sizeof(last_key_text) - 1);
-            last_key_text[sizeof(last_key_text) - 1] = '\0';
-            last_key_time = k_uptime_get();
-            update_key_display();
+            k_spinlock_key_t key = k_spin_lock(&pending_lock);
+            strncpy(pending_key_text, key_name, sizeof(pending_key_text) - 1);
+            pending_key_time = k_uptime_get();
+            pending_flags |= PENDING_KEY;
+            k_spin_unlock(&pending_lock, key);
         }
     }
     
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+    count_event();
+#endif
     return 0;
 }
 
@@ -571,6 +768,7 @@ lv_obj_t *zmk_display_status_screen(void) {
         
         current_layer = zmk_keymap_highest_layer_active();
         if (current_layer >= MAX_LAYERS) current_layer = 0;
+        listener_layer = current_layer;
         
         force_layer_update = true;
     }
@@ -1,5 +1,18 @@
 #pragma once
 
 #include <lvgl.h>
+#include <stdint.h>
 
-lv_obj_t *zmk_display_status_screen();
\ No newline at end of file
+lv_obj_t *zmk_display_status_screen();
+
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+struct stryke_display_stats {
+    uint32_t events;
+    uint32_t redraws;
+    uint32_t max_events_per_redraw;
+    uint32_t frames;
+    uint32_t max_frame_late_ms;
+};
+
+void stryke_display_get_stats(struct stryke_display_stats *stats);
+#endif
\ No newline at end of file
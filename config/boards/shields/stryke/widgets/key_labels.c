@@ -0,0 +1,147 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <zmk/matrix.h>
+#include <dt-bindings/zmk/hid_usage.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include <dt-bindings/zmk/modifiers.h>
+#include "key_labels.h"
+#include "keymap_bindings.h"
+
+static const struct zmk_behavior_binding default_bindings[][ZMK_KEYMAP_LEN] = {
+    STRYKE_DEFAULT_BINDINGS
+};
+
+static const struct {
+    uint8_t mods;
+    const char *name;
+} mod_names[] = {
+    {MOD_LGUI | MOD_RGUI, "CMD"},
+    {MOD_LCTL | MOD_RCTL, "CTRL"},
+    {MOD_LALT | MOD_RALT, "ALT"},
+    {MOD_LSFT | MOD_RSFT, "SHFT"},
+};
+
+/* Keyboard page usages from Enter (0x28) through Up (0x52). */
+static const char *const key_usage_names[] = {
+    "ENTER", "ESC", "BSPC", "TAB", "SPACE", "MINUS", "EQUAL", "LBKT", "RBKT", "BSLH",
+    "NUHS", "SEMI", "SQT", "GRAVE", "COMMA", "DOT", "FSLH", "CAPS",
+    "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "F10", "F11", "F12",
+    "PSCRN", "SLCK", "PAUSE", "INS", "HOME", "PGUP", "DEL", "END", "PGDN",
+    "RIGHT", "LEFT", "DOWN", "UP",
+};
+
+/* Consumer page usages that media keys are usually remapped to. */
+static const struct {
+    uint16_t id;
+    const char *name;
+} consumer_usage_names[] = {
+    {HID_USAGE_CONSUMER_VOLUME_INCREMENT, "VOL+"},
+    {HID_USAGE_CONSUMER_VOLUME_DECREMENT, "VOL-"},
+    {HID_USAGE_CONSUMER_MUTE, "MUTE"},
+    {HID_USAGE_CONSUMER_PLAY_PAUSE, "PLAY"},
+    {HID_USAGE_CONSUMER_STOP, "STOP"},
+    {HID_USAGE_CONSUMER_SCAN_NEXT_TRACK, "NEXT"},
+    {HID_USAGE_CONSUMER_SCAN_PREVIOUS_TRACK, "PREV"},
+    {HID_USAGE_CONSUMER_DISPLAY_BRIGHTNESS_INCREMENT, "BRI+"},
+    {HID_USAGE_CONSUMER_DISPLAY_BRIGHTNESS_DECREMENT, "BRI-"},
+};
+
+static bool bindings_equal(const struct zmk_behavior_binding *a, const struct zmk_behavior_binding *b) {
+    return strcmp(a->behavior_dev, b->behavior_dev) == 0 && a->param1 == b->param1 &&
+           a->param2 == b->param2;
+}
+
+static void format_consumer_usage(uint16_t id, char *buf, size_t len) {
+    for (size_t i = 0; i < ARRAY_SIZE(consumer_usage_names); i++) {
+        if (consumer_usage_names[i].id == id) {
+            snprintf(buf, len, "%s", consumer_usage_names[i].name);
+            return;
+        }
+    }
+
+    snprintf(buf, len, "MEDIA");
+}
+
+static void format_usage(uint32_t keycode, char *buf, size_t len) {
+    uint16_t id = ZMK_HID_USAGE_ID(keycode);
+
+    if (ZMK_HID_USAGE_PAGE(keycode) == HID_USAGE_CONSUMER) {
+        format_consumer_usage(id, buf, len);
+    } else if (ZMK_HID_USAGE_PAGE(keycode) != HID_USAGE_KEY) {
+        snprintf(buf, len, "KEY");
+    } else if (id >= HID_USAGE_KEY_KEYBOARD_A_AND_A && id <= HID_USAGE_KEY_KEYBOARD_Z_AND_Z) {
+        snprintf(buf, len, "%c", 'A' + (id - HID_USAGE_KEY_KEYBOARD_A_AND_A));
+    } else if (id >= HID_USAGE_KEY_KEYBOARD_1_AND_EXCLAMATION && id < HID_USAGE_KEY_KEYBOARD_0_AND_RIGHT_PARENTHESIS) {
+        snprintf(buf, len, "%c", '1' + (id - HID_USAGE_KEY_KEYBOARD_1_AND_EXCLAMATION));
+    } else if (id == HID_USAGE_KEY_KEYBOARD_0_AND_RIGHT_PARENTHESIS) {
+        snprintf(buf, len, "0");
+    } else if (id >= HID_USAGE_KEY_KEYBOARD_RETURN_ENTER &&
+               id - HID_USAGE_KEY_KEYBOARD_RETURN_ENTER < ARRAY_SIZE(key_usage_names)) {
+        snprintf(buf, len, "%s", key_usage_names[id - HID_USAGE_KEY_KEYBOARD_RETURN_ENTER]);
+    } else {
+        snprintf(buf, len, "0x%02X", id);
+    }
+}
+
+static void format_key_press(uint32_t keycode, char *buf, size_t len) {
+    uint8_t mods = SELECT_MODS(keycode);
+    size_t used = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(mod_names) && used < len; i++) {
+        if (mods & mod_names[i].mods) {
+            used += snprintf(buf + used, len - used, "%s+", mod_names[i].name);
+        }
+    }
+
+    if (used < len) {
+        format_usage(keycode, buf + used, len - used);
+    }
+}
+
+static void format_layer(const char *prefix, uint32_t layer, char *buf, size_t len) {
+    const char *name = zmk_keymap_layer_name(layer);
+
+    if (name != NULL) {
+        snprintf(buf, len, "%s%s", prefix, name);
+    } else {
+        snprintf(buf, len, "%sL%d", prefix, layer);
+    }
+}
+
+int stryke_key_label_from_binding(uint8_t layer, uint8_t position, char *buf, size_t len) {
+    if (layer >= ARRAY_SIZE(default_bindings) || position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    const struct zmk_behavior_binding *binding = zmk_keymap_get_layer_binding_at(layer, position);
+    if (binding == NULL || binding->behavior_dev == NULL) {
+        return -ENOENT;
+    }
+
+    if (bindings_equal(binding, &default_bindings[layer][position])) {
+        return -ENOENT;
+    }
+
+    const char *dev = binding->behavior_dev;
+    if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(kp))) {
+        format_key_press(binding->param1, buf, len);
+    } else if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(to))) {
+        format_layer("", binding->param1, buf, len);
+    } else if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(mo))) {
+        format_layer("MO ", binding->param1, buf, len);
+    } else if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(tog))) {
+        format_layer("TOG ", binding->param1, buf, len);
+    } else if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(none))) {
+        snprintf(buf, len, " ");
+    } else {
+        snprintf(buf, len, "%s", dev);
+    }
+
+    return 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Writes a label for the key's current binding into buf. Returns -ENOENT
+ * when the binding still matches the compiled keymap, so the caller can
+ * keep its hand-written label.
+ */
+int stryke_key_label_from_binding(uint8_t layer, uint8_t position, char *buf, size_t len);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+
+#define STRYKE_KEYMAP_NODE DT_INST(0, zmk_keymap)
+
+#define STRYKE_LAYER_BINDINGS(node)                                                                \
+    { LISTIFY(DT_PROP_LEN(node, bindings), ZMK_KEYMAP_EXTRACT_BINDING, (, ), node) }
+
+/*
+ * Initializer for a [layer][ZMK_KEYMAP_LEN] table of the bindings the
+ * keymap was compiled with.
+ */
+#define STRYKE_DEFAULT_BINDINGS                                                                    \
+    DT_FOREACH_CHILD_SEP(STRYKE_KEYMAP_NODE, STRYKE_LAYER_BINDINGS, (, ))
+
+/* Device name of the behavior with this node label, or NULL if the build has none. */
+#define STRYKE_BEHAVIOR_NAME(label)                                                                \
+    COND_CODE_1(DT_NODE_EXISTS(DT_NODELABEL(label)), (DEVICE_DT_NAME(DT_NODELABEL(label))), (NULL))
+
+static inline bool stryke_is_behavior(const char *dev, const char *name) {
+    return name != NULL && strcmp(dev, name) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/endpoints.h>
+#include "report_stats.h"
+
+LOG_MODULE_REGISTER(stryke_report_stats, CONFIG_ZMK_LOG_LEVEL);
+
+#define STATS_LOG_INTERVAL_MS 5000
+
+/* Reports further apart than this belong to separate presses, not a burst. */
+#define BURST_GAP_US 100000
+
+static struct k_spinlock stats_lock;
+static struct stryke_report_stats stats = {
+    .min_gap_us = UINT32_MAX,
+};
+static uint32_t last_send_cycles;
+
+static void log_stats_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(log_stats_work, log_stats_work_cb);
+
+void stryke_report_stats_get(struct stryke_report_stats *out) {
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    *out = stats;
+    k_spin_unlock(&stats_lock, key);
+}
+
+__weak void stryke_report_stats_on_send(uint16_t usage_page, int err) {}
+
+static void record_send(uint32_t start_cycles, uint32_t end_cycles, int err) {
+    uint32_t send_us = k_cyc_to_us_floor32(end_cycles - start_cycles);
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    if (stats.reports > 0) {
+        uint32_t gap_us = k_cyc_to_us_floor32(start_cycles - last_send_cycles);
+        if (gap_us < BURST_GAP_US) {
+            stats.burst_gaps++;
+            stats.total_gap_us += gap_us;
+            if (gap_us < stats.min_gap_us) {
+                stats.min_gap_us = gap_us;
+            }
+        }
+    }
+    last_send_cycles = start_cycles;
+
+    stats.reports++;
+    if (err < 0) {
+        stats.failed++;
+    }
+    stats.total_send_us += send_us;
+    if (send_us > stats.max_send_us) {
+        stats.max_send_us = send_us;
+    }
+    k_spin_unlock(&stats_lock, key);
+}
+
+/*
+ * The shield's CMakeLists links with --wrap=zmk_endpoints_send_report, so
+ * every report from ZMK's HID listener passes through here.
+ */
+int __real_zmk_endpoints_send_report(uint16_t usage_page);
+
+int __wrap_zmk_endpoints_send_report(uint16_t usage_page) {
+    uint32_t start_cycles = k_cycle_get_32();
+    int err = __real_zmk_endpoints_send_report(usage_page);
+    stryke_report_stats_on_send(usage_page, err);
+    record_send(start_cycles, k_cycle_get_32(), err);
+
+    if (!k_work_delayable_is_pending(&log_stats_work)) {
+        k_work_schedule(&log_stats_work, K_MSEC(STATS_LOG_INTERVAL_MS));
+    }
+
+    return err;
+}
+
+static void log_stats_work_cb(struct k_work *work) {
+    struct stryke_report_stats snapshot;
+    stryke_report_stats_get(&snapshot);
+
+    LOG_INF("Reports: %u sent, %u failed, send avg %u us max %u us", snapshot.reports,
+            snapshot.failed, (uint32_t)(snapshot.total_send_us / snapshot.reports),
+            snapshot.max_send_us);
+
+    if (snapshot.burst_gaps > 0) {
+        LOG_INF("Report bursts: %u gaps, min %u us avg %u us", snapshot.burst_gaps,
+                snapshot.min_gap_us, (uint32_t)(snapshot.total_gap_us / snapshot.burst_gaps));
+    }
+}
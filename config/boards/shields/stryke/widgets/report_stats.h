@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+
+struct stryke_report_stats {
+    uint32_t reports;
+    uint32_t failed;
+    uint32_t burst_gaps;
+    uint32_t min_gap_us;
+    uint64_t total_gap_us;
+    uint32_t max_send_us;
+    uint64_t total_send_us;
+};
+
+void stryke_report_stats_get(struct stryke_report_stats *stats);
+
+/*
+ * Called for every report from inside the timed send, after the endpoint
+ * has taken it. The default does nothing; test images override it.
+ */
+void stryke_report_stats_on_send(uint16_t usage_page, int err);
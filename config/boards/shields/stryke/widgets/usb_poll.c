@@ -0,0 +1,4 @@
+#include <zephyr/kernel.h>
+
+/* tests/usb-report-interval plays a host that polls the keyboard this often. */
+BUILD_ASSERT(CONFIG_USB_HID_POLL_INTERVAL_MS == 1, "USB HID polling interval must be 1 ms");
\ No newline at end of file
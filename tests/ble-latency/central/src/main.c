@@ -0,0 +1,189 @@
+/*
+ * BabbleSim central for the BLE report latency test. It connects to the
+ * first HID peripheral it sees, pairs, subscribes to the first keyboard
+ * input report and prints "STRYKE_NOTIFY <seq> <uptime us>" for every
+ * notification, and "STRYKE_CONN_PARAMS <interval> <latency> <timeout>"
+ * for the initial and every updated set of connection parameters. Both
+ * devices boot at simulation time zero, so these timestamps line up with
+ * the peripheral's STRYKE_REPORT lines.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+
+static struct bt_conn *default_conn;
+static struct bt_uuid_16 report_uuid = BT_UUID_INIT_16(BT_UUID_HIDS_REPORT_VAL);
+static struct bt_gatt_discover_params discover_params;
+static struct bt_gatt_subscribe_params subscribe_params;
+static uint32_t notify_seq;
+
+static void start_scan(void);
+
+static uint8_t notify_cb(struct bt_conn *conn, struct bt_gatt_subscribe_params *params,
+                         const void *data, uint16_t length) {
+    if (data == NULL) {
+        params->value_handle = 0;
+        return BT_GATT_ITER_STOP;
+    }
+
+    printk("STRYKE_NOTIFY %u %llu\n", notify_seq++, k_ticks_to_us_floor64(k_uptime_ticks()));
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static uint8_t discover_cb(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+                           struct bt_gatt_discover_params *params) {
+    if (attr == NULL) {
+        printk("No notifying HID report characteristic found\n");
+        return BT_GATT_ITER_STOP;
+    }
+
+    const struct bt_gatt_chrc *chrc = attr->user_data;
+    if (!(chrc->properties & BT_GATT_CHRC_NOTIFY)) {
+        return BT_GATT_ITER_CONTINUE;
+    }
+
+    /* ZMK declares the CCC right after the report value. */
+    subscribe_params.notify = notify_cb;
+    subscribe_params.value = BT_GATT_CCC_NOTIFY;
+    subscribe_params.value_handle = chrc->value_handle;
+    subscribe_params.ccc_handle = chrc->value_handle + 1;
+
+    int err = bt_gatt_subscribe(conn, &subscribe_params);
+    if (err && err != -EALREADY) {
+        printk("Subscribe failed (err %d)\n", err);
+    } else {
+        printk("Subscribed to report handle 0x%04x\n", chrc->value_handle);
+    }
+
+    return BT_GATT_ITER_STOP;
+}
+
+static void discover_reports(struct bt_conn *conn) {
+    discover_params.uuid = &report_uuid.uuid;
+    discover_params.func = discover_cb;
+    discover_params.start_handle = 0x0001;
+    discover_params.end_handle = 0xffff;
+    discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
+
+    int err = bt_gatt_discover(conn, &discover_params);
+    if (err) {
+        printk("Discover failed (err %d)\n", err);
+    }
+}
+
+static bool ad_has_hids(struct bt_data *data, void *user_data) {
+    bool *found = user_data;
+
+    if (data->type != BT_DATA_UUID16_SOME && data->type != BT_DATA_UUID16_ALL) {
+        return true;
+    }
+
+    for (size_t i = 0; i + 1 < data->data_len; i += 2) {
+        if (sys_get_le16(&data->data[i]) == BT_UUID_HIDS_VAL) {
+            *found = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void device_found(const bt_addr_le_t *addr, int8_t rssi, uint8_t type,
+                         struct net_buf_simple *ad) {
+    if (default_conn != NULL || type != BT_GAP_ADV_TYPE_ADV_IND) {
+        return;
+    }
+
+    bool found = false;
+    bt_data_parse(ad, ad_has_hids, &found);
+    if (!found) {
+        return;
+    }
+
+    if (bt_le_scan_stop()) {
+        return;
+    }
+
+    int err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN, BT_LE_CONN_PARAM_DEFAULT,
+                                &default_conn);
+    if (err) {
+        printk("Create connection failed (err %d)\n", err);
+        start_scan();
+    }
+}
+
+static void start_scan(void) {
+    int err = bt_le_scan_start(BT_LE_SCAN_ACTIVE, device_found);
+    if (err) {
+        printk("Scanning failed to start (err %d)\n", err);
+    }
+}
+
+static void connected(struct bt_conn *conn, uint8_t err) {
+    if (err) {
+        printk("Connection failed (err 0x%02x)\n", err);
+        bt_conn_unref(default_conn);
+        default_conn = NULL;
+        start_scan();
+        return;
+    }
+
+    printk("Connected\n");
+
+    struct bt_conn_info info;
+    if (bt_conn_get_info(conn, &info) == 0) {
+        printk("STRYKE_CONN_PARAMS %u %u %u\n", info.le.interval, info.le.latency, info.le.timeout);
+    }
+
+    /* ZMK's HID characteristics need an encrypted link. */
+    err = bt_conn_set_security(conn, BT_SECURITY_L2);
+    if (err) {
+        printk("Set security failed (err %d)\n", err);
+    }
+}
+
+static void disconnected(struct bt_conn *conn, uint8_t reason) {
+    printk("Disconnected (reason 0x%02x)\n", reason);
+
+    bt_conn_unref(default_conn);
+    default_conn = NULL;
+    start_scan();
+}
+
+static void security_changed(struct bt_conn *conn, bt_security_t level,
+                             enum bt_security_err err) {
+    if (err) {
+        printk("Security failed (err %d)\n", err);
+        return;
+    }
+
+    discover_reports(conn);
+}
+
+static void le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                             uint16_t timeout) {
+    printk("STRYKE_CONN_PARAMS %u %u %u\n", interval, latency, timeout);
+}
+
+BT_CONN_CB_DEFINE(conn_callbacks) = {
+    .connected = connected,
+    .disconnected = disconnected,
+    .security_changed = security_changed,
+    .le_param_updated = le_param_updated,
+};
+
+int main(void) {
+    int err = bt_enable(NULL);
+    if (err) {
+        printk("Bluetooth init failed (err %d)\n", err);
+        return 0;
+    }
+
+    start_scan();
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <posix_board_if.h>
+#include "harness.h"
+
+#define CHECK_INTERVAL_MS 100
+
+static const struct stryke_test *current_test;
+static int64_t last_activity_ms;
+
+static void check_done_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(check_done_work, check_done_work_cb);
+
+void stryke_test_activity(void) {
+    last_activity_ms = k_uptime_get();
+}
+
+bool stryke_test_check(bool ok, const char *what) {
+    if (!ok) {
+        printk("%s FAIL: %s\n", current_test->tag, what);
+    }
+    return ok;
+}
+
+static void check_done_work_cb(struct k_work *work) {
+    int64_t now = k_uptime_get();
+    bool finished = current_test->done() && now - last_activity_ms >= current_test->settle_ms;
+
+    if (!finished && now < current_test->timeout_ms) {
+        k_work_schedule(&check_done_work, K_MSEC(CHECK_INTERVAL_MS));
+        return;
+    }
+
+    bool pass = current_test->report(finished);
+    printk("%s %s\n", current_test->tag, pass ? "PASS" : "FAIL");
+    posix_exit(pass ? 0 : 1);
+}
+
+void stryke_test_start(const struct stryke_test *test) {
+    current_test = test;
+    k_work_schedule(&check_done_work, K_MSEC(CHECK_INTERVAL_MS));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* A native_sim test that waits for its traffic to finish, then exits with its result. */
+struct stryke_test {
+    /* Prefix for every line the test prints. */
+    const char *tag;
+    /* Simulated uptime after which the test reports whatever it has. */
+    int64_t timeout_ms;
+    /* Quiet time after the last activity before the result is final. */
+    int32_t settle_ms;
+    /* True once everything the test waits for has happened. */
+    bool (*done)(void);
+    /* Prints the measurements and returns whether they pass. */
+    bool (*report)(bool finished);
+};
+
+void stryke_test_start(const struct stryke_test *test);
+void stryke_test_activity(void);
+bool stryke_test_check(bool ok, const char *what);
@@ -0,0 +1,13 @@
+/*
+ * Built into the native simulator runner rather than the Zephyr image, so it
+ * can read the host clock.
+ */
+#include <stdint.h>
+#include <time.h>
+
+uint64_t stryke_test_host_time_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
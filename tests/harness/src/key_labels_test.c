@@ -0,0 +1,89 @@
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <zmk/behavior.h>
+#include <zmk/keymap.h>
+#include <dt-bindings/zmk/keys.h>
+#include "harness.h"
+#include "key_labels.h"
+#include "keymap_bindings.h"
+
+/* The keymap in tests/key-labels: layer 1 is named "Nav". */
+#define BASE_LAYER 0
+#define NAV_LAYER 1
+
+static bool check_label(uint8_t position, const struct zmk_behavior_binding binding,
+                        const char *expected) {
+    char label[32];
+
+    int err = zmk_keymap_set_layer_binding_at(BASE_LAYER, position, binding);
+    if (err < 0) {
+        printk("STRYKE_LABELS position %u: set binding failed (%d)\n", position, err);
+        return stryke_test_check(false, "could not change a binding");
+    }
+
+    err = stryke_key_label_from_binding(BASE_LAYER, position, label, sizeof(label));
+    printk("STRYKE_LABELS position %u: \"%s\" (%d), expected \"%s\"\n", position,
+           err == 0 ? label : "", err, expected);
+    return stryke_test_check(err == 0 && strcmp(label, expected) == 0,
+                             "label does not match the new binding");
+}
+
+static bool unchanged(uint8_t position) {
+    char label[32];
+
+    return stryke_key_label_from_binding(BASE_LAYER, position, label, sizeof(label)) == -ENOENT;
+}
+
+static bool report_results(bool finished) {
+    const struct zmk_behavior_binding default_binding =
+        *zmk_keymap_get_layer_binding_at(BASE_LAYER, 0);
+    bool pass = true;
+
+    pass &= stryke_test_check(unchanged(0), "compiled binding was labelled as remapped");
+
+    pass &= check_label(0,
+                        (struct zmk_behavior_binding){
+                            .behavior_dev = STRYKE_BEHAVIOR_NAME(kp),
+                            .param1 = C_VOL_UP,
+                        },
+                        "VOL+");
+    pass &= check_label(1,
+                        (struct zmk_behavior_binding){
+                            .behavior_dev = STRYKE_BEHAVIOR_NAME(kp),
+                            .param1 = LG(LS(N3)),
+                        },
+                        "CMD+SHFT+3");
+    pass &= check_label(2,
+                        (struct zmk_behavior_binding){
+                            .behavior_dev = STRYKE_BEHAVIOR_NAME(mo),
+                            .param1 = NAV_LAYER,
+                        },
+                        "MO Nav");
+
+    zmk_keymap_set_layer_binding_at(BASE_LAYER, 0, default_binding);
+    pass &= stryke_test_check(unchanged(0), "restored binding was labelled as remapped");
+
+    return pass;
+}
+
+static bool always_done(void) {
+    return true;
+}
+
+static const struct stryke_test key_labels_test = {
+    .tag = "STRYKE_LABELS",
+    .timeout_ms = 0,
+    .settle_ms = 0,
+    .done = always_done,
+    .report = report_results,
+};
+
+static int key_labels_test_init(void) {
+    stryke_test_start(&key_labels_test);
+    return 0;
+}
+
+SYS_INIT(key_labels_test_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,12 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include "report_stats.h"
+
+static uint32_t report_seq;
+
+void stryke_report_stats_on_send(uint16_t usage_page, int err) {
+    if (usage_page != HID_USAGE_KEY) return;
+
+    printk("STRYKE_REPORT %u %llu\n", report_seq++, k_ticks_to_us_floor64(k_uptime_ticks()));
+}
@@ -0,0 +1,315 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <zmk/behavior.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/hid.h>
+#include <zmk/keymap.h>
+#include <dt-bindings/zmk/hid_usage.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include <dt-bindings/zmk/kscan_mock.h>
+#include <dt-bindings/zmk/matrix_transform.h>
+#include <dt-bindings/zmk/modifiers.h>
+#include "harness.h"
+#include "keymap_bindings.h"
+#include "report_stats.h"
+
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+#include "custom_status.h"
+#endif
+
+#define KSCAN_NODE DT_CHOSEN(zmk_kscan)
+#define TRANSFORM_NODE DT_CHOSEN(zmk_matrix_transform)
+
+/* Quiet time after the last expected report before the result is final. */
+#define SETTLE_MS 500
+#define MAX_MISMATCH_LOGS 10
+
+static const struct zmk_behavior_binding bindings[][ZMK_KEYMAP_LEN] = {
+    STRYKE_DEFAULT_BINDINGS
+};
+
+static const uint32_t mock_events[] = DT_PROP(KSCAN_NODE, events);
+static const uint32_t transform_map[] = DT_PROP(TRANSFORM_NODE, map);
+
+/* ZMK's kscan event queue, defined in app/src/physical_layouts.c. */
+extern struct k_msgq physical_layouts_kscan_msgq;
+
+/* From host_clock.c, which runs on the host side of the native simulator. */
+uint64_t stryke_test_host_time_ns(void);
+
+/*
+ * Replays the mock kscan events against the keymap: &kp holds its usage,
+ * &to and &mo change layers, and a release uses the layer its press
+ * resolved on, as ZMK does.
+ */
+struct keymap_model {
+    uint32_t layers;
+    size_t cursor;
+    uint8_t press_layer[ZMK_KEYMAP_LEN];
+    uint8_t held[ZMK_KEYMAP_LEN];
+};
+
+/* Everything below runs on the system work queue, so it needs no locking. */
+static struct keymap_model model = {
+    .layers = BIT(0),
+};
+static uint32_t expected_reports;
+static uint32_t reports_checked;
+static uint32_t report_mismatches;
+
+static uint32_t position_events;
+static int64_t first_event_ms;
+static int64_t last_event_ms;
+static uint32_t max_queue_depth;
+
+static uint32_t pipelines;
+static uint64_t pipeline_total_ns;
+static uint64_t pipeline_max_ns;
+
+static bool setup_ok;
+
+static int event_position(uint32_t ev) {
+    uint32_t rc = RC(ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev));
+
+    for (size_t i = 0; i < ARRAY_SIZE(transform_map); i++) {
+        if (transform_map[i] == rc) {
+            return i;
+        }
+    }
+    return -ENOENT;
+}
+
+/* Apply the next event; returns true if it changes the keys in the report. */
+static bool model_step(struct keymap_model *m) {
+    uint32_t ev = mock_events[m->cursor++];
+    bool pressed = ZMK_MOCK_IS_PRESS(ev);
+    int position = event_position(ev);
+
+    if (position < 0) {
+        return false;
+    }
+
+    if (pressed) {
+        m->press_layer[position] = find_msb_set(m->layers) - 1;
+    }
+
+    const struct zmk_behavior_binding *binding = &bindings[m->press_layer[position]][position];
+    const char *dev = binding->behavior_dev;
+
+    if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(kp))) {
+        m->held[position] = pressed ? ZMK_HID_USAGE_ID(binding->param1) : 0;
+        return true;
+    }
+
+    if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(to)) && pressed) {
+        m->layers = BIT(0) | BIT(binding->param1);
+    } else if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(mo))) {
+        WRITE_BIT(m->layers, binding->param1, pressed);
+        m->layers |= BIT(0);
+    }
+    return false;
+}
+
+static bool model_next_report(struct keymap_model *m) {
+    while (m->cursor < ARRAY_SIZE(mock_events)) {
+        if (model_step(m)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool model_holds(const struct keymap_model *m, uint8_t usage) {
+    for (size_t i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        if (m->held[i] == usage) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool report_matches(const struct keymap_model *m, const struct zmk_hid_keyboard_report *report) {
+    size_t expected = 0;
+    size_t actual = 0;
+
+    if (report->body.modifiers != 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        if (m->held[i] != 0) {
+            expected++;
+        }
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(report->body.keys); i++) {
+        uint8_t usage = report->body.keys[i];
+        if (usage == 0) {
+            continue;
+        }
+        if (!model_holds(m, usage)) {
+            return false;
+        }
+        actual++;
+    }
+
+    return actual == expected;
+}
+
+void stryke_report_stats_on_send(uint16_t usage_page, int err) {
+    if (usage_page != HID_USAGE_KEY) return;
+
+    /* No transport is configured, so err is expected; check the report contents. */
+    reports_checked++;
+    stryke_test_activity();
+
+    if (model_next_report(&model) && report_matches(&model, zmk_hid_get_keyboard_report())) {
+        return;
+    }
+
+    if (++report_mismatches <= MAX_MISMATCH_LOGS) {
+        printk("STRYKE_STRESS mismatch: report %u after event %zu of %zu\n", reports_checked,
+               model.cursor, ARRAY_SIZE(mock_events));
+    }
+}
+
+int __real_zmk_event_manager_raise(zmk_event_t *event);
+
+/*
+ * Linked with --wrap=zmk_event_manager_raise. A position event runs the
+ * keymap, the HID report and the status screen synchronously, so timing
+ * its raise times the whole pipeline for one key event.
+ */
+int __wrap_zmk_event_manager_raise(zmk_event_t *event) {
+    if (as_zmk_position_state_changed(event) == NULL) {
+        return __real_zmk_event_manager_raise(event);
+    }
+
+    uint64_t start_ns = stryke_test_host_time_ns();
+    int ret = __real_zmk_event_manager_raise(event);
+    uint64_t elapsed_ns = stryke_test_host_time_ns() - start_ns;
+
+    pipelines++;
+    pipeline_total_ns += elapsed_ns;
+    pipeline_max_ns = MAX(pipeline_max_ns, elapsed_ns);
+
+    return ret;
+}
+
+static int stress_position_cb(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL) return 0;
+
+    if (position_events++ == 0) {
+        first_event_ms = ev->timestamp;
+    }
+    last_event_ms = ev->timestamp;
+
+    max_queue_depth = MAX(max_queue_depth, k_msgq_num_used_get(&physical_layouts_kscan_msgq));
+    return 0;
+}
+
+ZMK_LISTENER(stryke_stress, stress_position_cb);
+ZMK_SUBSCRIPTION(stryke_stress, zmk_position_state_changed);
+
+static bool report_results(bool finished) {
+    int64_t span_ms = last_event_ms - first_event_ms;
+    uint32_t rate = span_ms > 0 ? (uint32_t)(position_events * 1000LL / span_ms) : 0;
+    uint32_t pipeline_avg_us = pipelines ? (uint32_t)(pipeline_total_ns / pipelines / 1000) : 0;
+    uint32_t pipeline_max_us = (uint32_t)(pipeline_max_ns / 1000);
+    bool pass = setup_ok;
+
+    printk("STRYKE_STRESS events %u/%zu at %u/s\n", position_events, ARRAY_SIZE(mock_events), rate);
+    printk("STRYKE_STRESS reports %u/%u checked, %u mismatched\n", reports_checked,
+           expected_reports, report_mismatches);
+    printk("STRYKE_STRESS kscan queue max depth %u/%d\n", max_queue_depth,
+           CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE);
+    printk("STRYKE_STRESS pipeline avg %u us max %u us\n", pipeline_avg_us, pipeline_max_us);
+
+#if IS_ENABLED(CONFIG_STRYKE_DISPLAY_STATS)
+    struct stryke_display_stats display;
+    stryke_display_get_stats(&display);
+    printk("STRYKE_STRESS display %u events, %u redraws, max %u events in a redraw\n",
+           display.events, display.redraws, display.max_events_per_redraw);
+    printk("STRYKE_STRESS display %u frames, max %u ms late\n", display.frames,
+           display.max_frame_late_ms);
+    pass &= stryke_test_check(
+        display.max_frame_late_ms <= CONFIG_STRYKE_TEST_STRESS_MAX_FRAME_LATE_MS,
+        "status screen timer fell behind");
+#endif
+
+    pass &= stryke_test_check(finished, "timed out before every expected report arrived");
+    pass &= stryke_test_check(position_events == ARRAY_SIZE(mock_events),
+                              "key events were dropped");
+    pass &= stryke_test_check(reports_checked == expected_reports && report_mismatches == 0,
+                              "keyboard reports did not match the keymap");
+    pass &= stryke_test_check(max_queue_depth < CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE,
+                              "kscan queue filled up");
+    pass &= stryke_test_check(rate >= CONFIG_STRYKE_TEST_STRESS_MIN_EVENT_RATE,
+                              "event rate below threshold");
+    pass &= stryke_test_check(pipeline_max_us <= CONFIG_STRYKE_TEST_STRESS_MAX_PIPELINE_US,
+                              "key event pipeline slower than threshold");
+    return pass;
+}
+
+static bool all_reports_checked(void) {
+    return reports_checked >= expected_reports;
+}
+
+static const struct stryke_test stress_test = {
+    .tag = "STRYKE_STRESS",
+    .timeout_ms = CONFIG_STRYKE_TEST_STRESS_TIMEOUT_MS,
+    .settle_ms = SETTLE_MS,
+    .done = all_reports_checked,
+    .report = report_results,
+};
+
+/* The model only covers plain &kp, &to and &mo bindings. */
+static bool keymap_supported(void) {
+    for (size_t layer = 0; layer < ARRAY_SIZE(bindings); layer++) {
+        for (size_t position = 0; position < ZMK_KEYMAP_LEN; position++) {
+            const struct zmk_behavior_binding *binding = &bindings[layer][position];
+            const char *dev = binding->behavior_dev;
+
+            if (stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(kp))) {
+                if (ZMK_HID_USAGE_PAGE(binding->param1) != HID_USAGE_KEY ||
+                    SELECT_MODS(binding->param1) != 0) {
+                    return false;
+                }
+            } else if (!stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(to)) && !stryke_is_behavior(dev, STRYKE_BEHAVIOR_NAME(mo))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static int stress_init(void) {
+    struct keymap_model scratch = {
+        .layers = BIT(0),
+    };
+
+    stryke_test_start(&stress_test);
+
+    bool positions_ok = true;
+    for (size_t i = 0; i < ARRAY_SIZE(mock_events); i++) {
+        positions_ok &= event_position(mock_events[i]) >= 0;
+    }
+
+    setup_ok = stryke_test_check(keymap_supported(),
+                                 "keymap uses bindings the model does not cover");
+    setup_ok &= stryke_test_check(positions_ok, "mock events outside the matrix transform");
+
+    while (model_next_report(&scratch)) {
+        expected_reports++;
+    }
+
+    return 0;
+}
+
+SYS_INIT(stress_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,170 @@
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <dt-bindings/zmk/hid_usage_pages.h>
+#include <dt-bindings/zmk/kscan_mock.h>
+#include "harness.h"
+#include "report_stats.h"
+
+#define KSCAN_NODE DT_CHOSEN(zmk_kscan)
+
+/* Every mock event is a &kp press or release, so each one sends a report. */
+#define EXPECTED_REPORTS DT_PROP_LEN(KSCAN_NODE, events)
+
+/* zmk_usb_hid_send_report() gives up on a busy endpoint after this long. */
+#define IN_EP_WRITE_TIMEOUT_MS 30
+
+/* Quiet time after the last expected report before the result is final. */
+#define SETTLE_MS 100
+
+/* Free while the IN endpoint is empty; the host poll gives it back. */
+static K_SEM_DEFINE(in_ep_sem, 1, 1);
+
+static struct k_spinlock in_ep_lock;
+static bool in_ep_full;
+static uint32_t reports_submitted;
+static uint32_t reports_timed_out;
+static uint32_t reports_delivered;
+static uint32_t reports_extra;
+
+static const uint32_t mock_events[] = DT_PROP(KSCAN_NODE, events);
+
+/* When each report was ready to send, and when the host read it. */
+static int64_t ready_ticks[EXPECTED_REPORTS];
+static int64_t delivered_ticks[EXPECTED_REPORTS];
+
+static void host_poll_cb(struct k_timer *timer);
+static K_TIMER_DEFINE(host_poll_timer, host_poll_cb, NULL);
+
+void stryke_report_stats_on_send(uint16_t usage_page, int err) {
+    if (usage_page != HID_USAGE_KEY) return;
+
+    int64_t now = k_uptime_ticks();
+
+    if (k_sem_take(&in_ep_sem, K_MSEC(IN_EP_WRITE_TIMEOUT_MS)) != 0) {
+        reports_timed_out++;
+        return;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&in_ep_lock);
+    if (reports_submitted < EXPECTED_REPORTS) {
+        ready_ticks[reports_submitted] = now;
+    }
+    reports_submitted++;
+    in_ep_full = true;
+    k_spin_unlock(&in_ep_lock, key);
+}
+
+static void host_poll_cb(struct k_timer *timer) {
+    k_spinlock_key_t key = k_spin_lock(&in_ep_lock);
+    if (!in_ep_full) {
+        k_spin_unlock(&in_ep_lock, key);
+        return;
+    }
+
+    if (reports_delivered < EXPECTED_REPORTS) {
+        delivered_ticks[reports_delivered++] = k_uptime_ticks();
+    } else {
+        reports_extra++;
+    }
+    in_ep_full = false;
+    k_spin_unlock(&in_ep_lock, key);
+
+    k_sem_give(&in_ep_sem);
+    stryke_test_activity();
+}
+
+static bool report_results(bool finished) {
+    int64_t poll_ticks = k_ms_to_ticks_ceil64(CONFIG_STRYKE_TEST_USB_POLL_INTERVAL_MS);
+    int64_t pressed_ticks = 0;
+    uint64_t latency_total_us = 0;
+    uint32_t latency_max_us = 0;
+    uint32_t missed_polls = 0;
+    uint32_t queued = 0;
+    uint64_t queued_total_us = 0;
+    uint32_t queued_min_us = UINT32_MAX;
+    uint32_t queued_max_us = 0;
+    bool pass = true;
+
+    k_timer_stop(&host_poll_timer);
+
+    for (uint32_t i = 0; i < reports_delivered; i++) {
+        /*
+         * A report is ready as soon as its key event is processed, unless
+         * the work queue was still blocked on the previous report. Keys
+         * with no delay in the mock were all pressed together, so their
+         * latency counts from the first of them.
+         */
+        if (i == 0 || ZMK_MOCK_MSEC(mock_events[i]) > 0) {
+            pressed_ticks = ready_ticks[i];
+        }
+
+        uint32_t latency_us = k_ticks_to_us_floor32(delivered_ticks[i] - pressed_ticks);
+        latency_total_us += latency_us;
+        latency_max_us = MAX(latency_max_us, latency_us);
+
+        /* The host should read each report at the first poll after it could be queued. */
+        int64_t queued_ticks = ready_ticks[i];
+        if (i > 0) {
+            queued_ticks = MAX(queued_ticks, delivered_ticks[i - 1]);
+        }
+        if (delivered_ticks[i] - queued_ticks > poll_ticks) {
+            missed_polls++;
+        }
+
+        /* Report i was waiting on the endpoint when the host read report i - 1. */
+        if (i > 0 && ready_ticks[i] <= delivered_ticks[i - 1]) {
+            uint32_t interval_us = k_ticks_to_us_floor32(delivered_ticks[i] - delivered_ticks[i - 1]);
+            queued++;
+            queued_total_us += interval_us;
+            queued_min_us = MIN(queued_min_us, interval_us);
+            queued_max_us = MAX(queued_max_us, interval_us);
+        }
+    }
+
+    struct stryke_report_stats stats;
+    stryke_report_stats_get(&stats);
+
+    printk("STRYKE_USB reports %u/%d delivered, %u timed out, %u extra, polled every %u ms\n",
+           reports_delivered, EXPECTED_REPORTS, reports_timed_out, reports_extra,
+           CONFIG_STRYKE_TEST_USB_POLL_INTERVAL_MS);
+    printk("STRYKE_USB key to host latency avg %u us max %u us, %u missed polls\n",
+           reports_delivered ? (uint32_t)(latency_total_us / reports_delivered) : 0, latency_max_us,
+           missed_polls);
+    if (queued > 0) {
+        printk("STRYKE_USB queued reports %u, interval min %u us avg %u us max %u us\n", queued,
+               queued_min_us, (uint32_t)(queued_total_us / queued), queued_max_us);
+    }
+    printk("STRYKE_USB send blocked max %u us, burst gap min %u us\n", stats.max_send_us,
+           stats.burst_gaps ? stats.min_gap_us : 0);
+
+    pass &= stryke_test_check(finished, "timed out before every report reached the host");
+    pass &= stryke_test_check(reports_delivered == EXPECTED_REPORTS && reports_timed_out == 0 &&
+                                  reports_extra == 0,
+                              "reports were lost or duplicated");
+    pass &= stryke_test_check(missed_polls <= CONFIG_STRYKE_TEST_USB_MAX_MISSED_POLLS,
+                              "reports waited past the poll that could have read them");
+    return pass;
+}
+
+static bool all_reports_delivered(void) {
+    return reports_delivered >= EXPECTED_REPORTS;
+}
+
+static const struct stryke_test usb_test = {
+    .tag = "STRYKE_USB",
+    .timeout_ms = CONFIG_STRYKE_TEST_USB_TIMEOUT_MS,
+    .settle_ms = SETTLE_MS,
+    .done = all_reports_delivered,
+    .report = report_results,
+};
+
+static int usb_stand_in_init(void) {
+    k_timer_start(&host_poll_timer, K_MSEC(CONFIG_STRYKE_TEST_USB_POLL_INTERVAL_MS),
+                  K_MSEC(CONFIG_STRYKE_TEST_USB_POLL_INTERVAL_MS));
+    stryke_test_start(&usb_test);
+    return 0;
+}
+
+SYS_INIT(usb_stand_in_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
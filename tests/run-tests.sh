@@ -0,0 +1,237 @@
+#!/usr/bin/env bash
+#
+# Build and run the stryke firmware tests against a ZMK checkout.
+#
+#   tests/run-tests.sh [test ...]
+#
+# With no arguments every test runs. ZMK_APP points at zmk/app in the west
+# workspace created from config/west.yml. The stress, USB and key label
+# tests run on native_sim and need only a host toolchain. The BabbleSim test
+# also needs BSIM_OUT_PATH (and the BSIM_COMPONENTS_PATH Zephyr expects for
+# nrf52_bsim). Build output and logs go to BUILD_DIR.
+
+set -euo pipefail
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+TESTS_DIR="$ROOT_DIR/tests"
+ZMK_APP=${ZMK_APP:-$ROOT_DIR/../zmk/app}
+BUILD_DIR=${BUILD_DIR:-$ROOT_DIR/.build/tests}
+EXTRA_MODULES="$ROOT_DIR;$TESTS_DIR/harness"
+
+# BLE connection profiles the firmware is built with (1.25 ms interval units),
+# and latency thresholds in microseconds from report submission to the
+# central's notification callback in each phase.
+BLE_SIM_LENGTH_US=${BLE_SIM_LENGTH_US:-25000000}
+BLE_EXPECTED_REPORTS=244
+BLE_ACTIVE_MAX_INT=${BLE_ACTIVE_MAX_INT:-12}
+BLE_IDLE_MIN_INT=${BLE_IDLE_MIN_INT:-24}
+BLE_IDLE_MAX_INT=${BLE_IDLE_MAX_INT:-40}
+BLE_IDLE_LATENCY=${BLE_IDLE_LATENCY:-30}
+BLE_ACTIVE_MAX_US=${BLE_ACTIVE_MAX_US:-18000}
+BLE_IDLE_MAX_US=${BLE_IDLE_MAX_US:-60000}
+
+# Keystroke storm thresholds: key events per second of simulated time, host
+# time for one key event to get through every listener, and simulated
+# time lateness of the status screen timer.
+STRESS_MIN_EVENT_RATE=${STRESS_MIN_EVENT_RATE:-1000}
+STRESS_MAX_PIPELINE_US=${STRESS_MAX_PIPELINE_US:-5000}
+STRESS_MAX_FRAME_LATE_MS=${STRESS_MAX_FRAME_LATE_MS:-10}
+
+# USB threshold: reports the host could have read at an earlier poll.
+USB_MAX_MISSED_POLLS=${USB_MAX_MISSED_POLLS:-0}
+
+ALL_TESTS=(ble-latency stress usb-report-interval key-labels)
+
+# build <build name> <board> <test dir> [cmake args...]
+build() {
+    local name=$1 board=$2 test=$3
+    shift 3
+
+    if ! west build -p auto -b "$board" -d "$BUILD_DIR/$name" -s "$ZMK_APP" -- \
+        -DZMK_CONFIG="$TESTS_DIR/$test" -DZMK_EXTRA_MODULES="$EXTRA_MODULES" "$@" \
+        > "$BUILD_DIR/$name.build.log" 2>&1; then
+        echo "FAIL: $name did not build, see $BUILD_DIR/$name.build.log"
+        return 1
+    fi
+}
+
+# run_bsim <build name>: run one peripheral image against the central.
+run_bsim() {
+    local name=$1
+    local sim_id="stryke_$name"
+
+    (cd "$BSIM_OUT_PATH/bin" && ./bs_2G4_phy_v1 -s="$sim_id" -D=2 -sim_length="$BLE_SIM_LENGTH_US") \
+        > "$BUILD_DIR/$name.phy.log" 2>&1 &
+    "$BUILD_DIR/$name/zephyr/zephyr.exe" -s="$sim_id" -d=0 > "$BUILD_DIR/$name.peripheral.log" 2>&1 &
+    "$BUILD_DIR/ble-central/zephyr/zephyr.exe" -s="$sim_id" -d=1 > "$BUILD_DIR/$name.central.log" 2>&1
+    wait
+}
+
+# run_native <build name> <tag>: run a native_sim image that prints "<tag> PASS"
+# or "<tag> FAIL" and exits with its result.
+run_native() {
+    local name=$1 tag=$2
+    local status=0
+
+    "$BUILD_DIR/$name/zephyr/zephyr.exe" > "$BUILD_DIR/$name.log" 2>&1 || status=$?
+    grep -o "$tag .*" "$BUILD_DIR/$name.log" || true
+
+    if ! grep -q "$tag PASS" "$BUILD_DIR/$name.log"; then
+        status=1
+    fi
+    return $status
+}
+
+# ble_latency <build name>: print "<reports> <received> <active params seen>
+# <idle params seen> <active n> <active mean us> <active max us> <idle n>
+# <idle mean us> <idle max us>". Each notification is put in the phase of
+# the connection parameters the central last reported.
+ble_latency() {
+    local name=$1
+
+    awk -v active_max_int="$BLE_ACTIVE_MAX_INT" -v idle_min_int="$BLE_IDLE_MIN_INT" \
+        -v idle_max_int="$BLE_IDLE_MAX_INT" -v idle_latency="$BLE_IDLE_LATENCY" '
+        { tag = "" }
+        {
+            for (i = 1; i < NF; i++) {
+                if ($i == "STRYKE_REPORT" || $i == "STRYKE_NOTIFY") {
+                    tag = $i; seq = $(i + 1); t = $(i + 2)
+                } else if ($i == "STRYKE_CONN_PARAMS") {
+                    tag = $i; interval = $(i + 1); latency = $(i + 2)
+                }
+            }
+        }
+        tag == "STRYKE_REPORT" { sent[seq] = t; reports++ }
+        tag == "STRYKE_CONN_PARAMS" {
+            phase = ""
+            if (latency == 0 && interval <= active_max_int) {
+                phase = "active"; seen["active"] = 1
+            } else if (latency == idle_latency && interval >= idle_min_int && interval <= idle_max_int) {
+                phase = "idle"; seen["idle"] = 1
+            }
+        }
+        tag == "STRYKE_NOTIFY" && (seq in sent) {
+            received++
+            if (phase != "") {
+                d = t - sent[seq]; n[phase]++; sum[phase] += d
+                if (d > max[phase]) max[phase] = d
+            }
+        }
+        END {
+            printf "%d %d %d %d", reports, received, seen["active"], seen["idle"]
+            split("active idle", phases, " ")
+            for (p = 1; p <= 2; p++) {
+                ph = phases[p]
+                printf " %d %d %d", n[ph], n[ph] ? sum[ph] / n[ph] : 0, max[ph]
+            }
+            printf "\n"
+        }
+    ' "$BUILD_DIR/$name.peripheral.log" "$BUILD_DIR/$name.central.log"
+}
+
+test_ble_latency() {
+    if [ -z "${BSIM_OUT_PATH:-}" ]; then
+        echo "FAIL: ble-latency needs BSIM_OUT_PATH pointing at a BabbleSim build"
+        return 1
+    fi
+
+    if ! west build -p auto -b nrf52_bsim -d "$BUILD_DIR/ble-central" -s "$TESTS_DIR/ble-latency/central" \
+        > "$BUILD_DIR/ble-central.build.log" 2>&1; then
+        echo "FAIL: ble-central did not build, see $BUILD_DIR/ble-central.build.log"
+        return 1
+    fi
+
+    build ble-latency nrf52_bsim ble-latency \
+        -DCONFIG_STRYKE_BLE_ACTIVE_MAX_INT="$BLE_ACTIVE_MAX_INT" \
+        -DCONFIG_STRYKE_BLE_IDLE_MIN_INT="$BLE_IDLE_MIN_INT" \
+        -DCONFIG_STRYKE_BLE_IDLE_MAX_INT="$BLE_IDLE_MAX_INT" \
+        -DCONFIG_STRYKE_BLE_IDLE_LATENCY="$BLE_IDLE_LATENCY" || return 1
+
+    run_bsim ble-latency
+
+    local reports received seen_active seen_idle a_n a_mean a_max i_n i_mean i_max
+    read -r reports received seen_active seen_idle a_n a_mean a_max i_n i_mean i_max \
+        < <(ble_latency ble-latency)
+
+    echo "ble-latency: $received/$reports reports"
+    echo "ble-latency active: $a_n reports, mean ${a_mean} us, max ${a_max} us"
+    echo "ble-latency idle:   $i_n reports, mean ${i_mean} us, max ${i_max} us"
+
+    local status=0
+    if [ "$reports" -ne "$BLE_EXPECTED_REPORTS" ] || [ "$received" -ne "$BLE_EXPECTED_REPORTS" ]; then
+        echo "FAIL: ble-latency expected $BLE_EXPECTED_REPORTS reports sent and received"
+        status=1
+    fi
+    if [ "$seen_active" -ne 1 ]; then
+        echo "FAIL: ble-latency central never saw latency 0 with an interval of at most $BLE_ACTIVE_MAX_INT"
+        status=1
+    fi
+    if [ "$seen_idle" -ne 1 ]; then
+        echo "FAIL: ble-latency central never saw the idle parameters"
+        status=1
+    fi
+    if [ "$a_n" -eq 0 ] || [ "$i_n" -eq 0 ]; then
+        echo "FAIL: ble-latency needs reports in both the active and the idle phase"
+        status=1
+    fi
+    if [ "$a_max" -gt "$BLE_ACTIVE_MAX_US" ]; then
+        echo "FAIL: ble-latency active max ${a_max} us exceeds ${BLE_ACTIVE_MAX_US} us"
+        status=1
+    fi
+    if [ "$i_max" -gt "$BLE_IDLE_MAX_US" ]; then
+        echo "FAIL: ble-latency idle max ${i_max} us exceeds ${BLE_IDLE_MAX_US} us"
+        status=1
+    fi
+    if [ "$a_mean" -ge "$i_mean" ]; then
+        echo "FAIL: ble-latency active mean is not below the idle mean"
+        status=1
+    fi
+
+    return $status
+}
+
+test_stress() {
+    build stress native_sim stress \
+        -DCONFIG_STRYKE_TEST_STRESS_MIN_EVENT_RATE="$STRESS_MIN_EVENT_RATE" \
+        -DCONFIG_STRYKE_TEST_STRESS_MAX_PIPELINE_US="$STRESS_MAX_PIPELINE_US" \
+        -DCONFIG_STRYKE_TEST_STRESS_MAX_FRAME_LATE_MS="$STRESS_MAX_FRAME_LATE_MS" || return 1
+
+    run_native stress STRYKE_STRESS
+}
+
+test_usb_report_interval() {
+    build usb-report-interval native_sim usb-report-interval \
+        -DCONFIG_STRYKE_TEST_USB_MAX_MISSED_POLLS="$USB_MAX_MISSED_POLLS" || return 1
+
+    run_native usb-report-interval STRYKE_USB
+}
+
+test_key_labels() {
+    build key-labels native_sim key-labels || return 1
+
+    run_native key-labels STRYKE_LABELS
+}
+
+mkdir -p "$BUILD_DIR"
+
+tests=("$@")
+if [ ${#tests[@]} -eq 0 ]; then
+    tests=("${ALL_TESTS[@]}")
+fi
+
+failed=0
+for t in "${tests[@]}"; do
+    fn="test_${t//-/_}"
+    if ! declare -F "$fn" > /dev/null; then
+        echo "Unknown test: $t (available: ${ALL_TESTS[*]})"
+        exit 2
+    fi
+
+    if "$fn"; then
+        echo "PASS: $t"
+    else
+        failed=1
+    fi
+done
+
+exit $failed